@@ -0,0 +1,91 @@
+#!/usr/bin/env python
+"""
+Benchmark the nodal force computation (DASolver::getForcesInternal) that passes the
+aerodynamic loads to MELD for the aerostructural wing case. We run the primal once and
+then call the force computation repeatedly at the converged flow field. The first call
+builds the face-to-point force scatter, and the remaining calls reuse it.
+We report the wall time of the first call and the average wall time of the remaining calls,
+along with the getForcesInternal timer from the C++ profiling (max over processors).
+NOTE: volumeForceField is written to the disk only if debug is on, so it is not in the reported times.
+NOTE: like runScript.py, this script uses DARhoSimpleFoam, which is not built by dafoam_lite
+(its Allmake builds the incompressible library only), so it needs a full DAFoam installation
+that includes the getForcesInternal changes of dafoam_lite.
+Usage: ./preProcessing.sh && mpirun -np 4 python benchmark_forces.py -nCalls 50
+"""
+
+import time
+import argparse
+import numpy as np
+from mpi4py import MPI
+from dafoam import PYDAFOAM
+
+parser = argparse.ArgumentParser()
+# how many times to call the force computation
+parser.add_argument("-nCalls", help="number of force computations", type=int, default=50)
+args = parser.parse_args()
+
+gcomm = MPI.COMM_WORLD
+
+U0 = 100.0
+p0 = 101325.0
+nuTilda0 = 4.5e-5
+T0 = 300.0
+
+daOptions = {
+    "designSurfaces": ["wing"],
+    "solverName": "DARhoSimpleFoam",
+    "primalMinResTol": 1.0e-8,
+    "fsi": {"pRef": p0},
+    "primalBC": {
+        "U0": {"variable": "U", "patches": ["inout"], "value": [U0, 0.0, 0.0]},
+        "p0": {"variable": "p", "patches": ["inout"], "value": [p0]},
+        "T0": {"variable": "T", "patches": ["inout"], "value": [T0]},
+        "nuTilda0": {"variable": "nuTilda", "patches": ["inout"], "value": [nuTilda0]},
+        "useWallFunction": True,
+    },
+    "normalizeStates": {
+        "U": U0,
+        "p": p0,
+        "T": T0,
+        "nuTilda": 1e-3,
+        "phi": 1.0,
+    },
+    "profiling": {"active": True, "fileName": "profiling_forces.json", "print": False},
+}
+
+DASolver = PYDAFOAM(options=daOptions, comm=gcomm)
+DASolver()
+
+nPts, _ = DASolver._getSurfaceSize(DASolver.allWallsGroup)
+forces = np.zeros((nPts, 3), DASolver.dtype)
+
+# the first call builds the force scatter
+gcomm.Barrier()
+t0 = time.time()
+DASolver.solver.getForcesArray(forces)
+gcomm.Barrier()
+t1 = time.time()
+forces0 = forces.copy()
+
+for i in range(args.nCalls):
+    DASolver.solver.getForcesArray(forces)
+gcomm.Barrier()
+t2 = time.time()
+
+DASolver.collectProfiling("getForces")
+timer = DASolver.profilingStats["getForces"]["solver"]["timers"]["transfer:getForcesInternal"]
+
+# the forces should not change between calls because the flow field is fixed
+maxDiff = gcomm.allreduce(np.max(np.abs(forces - forces0), initial=0.0), op=MPI.MAX)
+fTot = gcomm.allreduce(np.sum(forces, axis=0), op=MPI.SUM)
+nPtsTot = gcomm.allreduce(nPts, op=MPI.SUM)
+
+if gcomm.rank == 0:
+    print("************ getForces benchmark: aerostructural wing ************")
+    print("number of surface points: %d" % nPtsTot)
+    print("first call time: %g s" % (t1 - t0))
+    print("average time of the remaining %d calls: %g s" % (args.nCalls, (t2 - t1) / args.nCalls))
+    print("getForcesInternal calls: %d" % timer["calls"]["max"])
+    print("getForcesInternal total time (max over processors): %g s" % timer["time"]["max"])
+    print("total force: %s" % fTot)
+    print("max force difference between calls: %g" % maxDiff)
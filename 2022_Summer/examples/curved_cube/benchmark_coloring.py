@@ -0,0 +1,98 @@
+#!/usr/bin/env python
+"""
+Benchmark the distance-2 coloring methods for the curved cube case. For each method in
+adjColoringOption, we report the coloring wall time and the number of dRdW colors. The time
+is from the coloring:calcD2Coloring profiling timer (max over processors, summed over the dRdW
+and dFdW colorings), so it excludes the setup of the coloring solver and the connectivity mats.
+NOTE: runColoring calls validateColoring and aborts if any coloring conflict is found.
+The results are printed and appended to benchmark_coloring.txt so that different rank counts
+can be compared, see benchmark_coloring.sh.
+Usage: mpirun -np 4 python benchmark_coloring.py
+"""
+
+import os
+import glob
+from mpi4py import MPI
+from petsc4py import PETSc
+from dafoam import PYDAFOAM
+
+gcomm = MPI.COMM_WORLD
+
+daOptions = {
+    "solverName": "DASimpleFoam",
+    "useAD": {"mode": "fd"},
+    "objFunc": {
+        "CD": {
+            "part1": {
+                "type": "force",
+                "source": "patchToFace",
+                "patches": ["walls"],
+                "directionMode": "fixedDirection",
+                "direction": [1.0, 0.0, 0.0],
+                "scale": 1.0,
+                "addToAdjoint": True,
+            }
+        },
+    },
+    "profiling": {"active": True, "fileName": "profiling_coloring.json", "print": False},
+}
+
+coloringOptions = [
+    {"method": "parallelD2", "ordering": "largestFirst"},
+    {"method": "jonesPlassmannD2", "ordering": "random"},
+    {"method": "jonesPlassmannD2", "ordering": "largestFirst"},
+]
+
+DASolver = PYDAFOAM(options=daOptions, comm=gcomm)
+nProcs = gcomm.size
+colorFile = "dRdWColoring_%d.bin" % nProcs
+
+results = []
+for coloringOption in coloringOptions:
+    # remove the saved colorings, otherwise runColoring will skip the computation
+    DASolver.cdRoot()
+    if gcomm.rank == 0:
+        for fileName in glob.glob("*Coloring_*_%d.bin" % nProcs) + glob.glob("*Coloring_%d.bin" % nProcs):
+            os.remove(fileName)
+    gcomm.Barrier()
+
+    DASolver.setOption("adjColoringOption", coloringOption)
+    DASolver.updateDAOption()
+
+    runName = "runColoring_%03d" % DASolver.nRunColorings
+    DASolver.runColoring()
+    timer = DASolver.profilingStats[runName]["coloring"]["timers"]["coloring:calcD2Coloring"]
+
+    # read the dRdW coloring back to count the colors
+    DASolver.cdRoot()
+    colors = PETSc.Vec().create(PETSc.COMM_WORLD)
+    viewer = PETSc.Viewer().createBinary(colorFile, mode="r", comm=PETSc.COMM_WORLD)
+    colors.load(viewer)
+    nColors = int(round(colors.max()[1])) + 1
+    colors.destroy()
+
+    results.append(
+        {
+            "method": coloringOption["method"],
+            "ordering": coloringOption["ordering"],
+            "time": timer["time"]["max"],
+            "nColors": nColors,
+        }
+    )
+
+if gcomm.rank == 0:
+    lines = []
+    for result in results:
+        lines.append(
+            "nProcs: %3d  method: %-16s  ordering: %-12s  time: %10.3f s  nColors: %5d"
+            % (
+                nProcs,
+                result["method"],
+                result["ordering"],
+                result["time"],
+                result["nColors"],
+            )
+        )
+    print("\n".join(lines), flush=True)
+    with open("benchmark_coloring.txt", "a") as f:
+        f.write("\n".join(lines) + "\n")
@@ -0,0 +1,22 @@
+#!/usr/bin/env bash
+
+# Run benchmark_coloring.py with different numbers of ranks and collect the
+# coloring time and color count in benchmark_coloring.txt
+# Usage: ./benchmark_coloring.sh 1 2 4 8
+
+if [ -z "$WM_PROJECT" ]; then
+  echo "OpenFOAM environment not found, forgot to source the OpenFOAM bashrc?"
+  exit 1
+fi
+
+nProcsList=${@:-"1 2 4 8"}
+
+rm -f benchmark_coloring.txt
+for nProcs in $nProcsList; do
+  # remove the old decomposition, otherwise decomposePar fails and we run with
+  # the processor folders decomposed for a different number of ranks
+  rm -rf processor*
+  mpirun -np $nProcs python benchmark_coloring.py > log_benchmark_coloring_$nProcs.txt
+done
+
+cat benchmark_coloring.txt
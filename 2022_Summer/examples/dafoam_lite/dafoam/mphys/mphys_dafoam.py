@@ -312,7 +312,10 @@ class DAFoamSolver(ImplicitComponent):
         DASolver.evalFunctions(funcs, evalFuncs=self.evalFuncs)
 
         # assign the computed flow states to outputs
-        outputs["dafoam_states"] = DASolver.getStates()
+        # OpenMDAO copies the values to its own vector so we can use a view here
+        statesView = DASolver.getStates(copy=False)
+        outputs["dafoam_states"] = statesView.getArray()
+        statesView.release()
 
         # if the primal solution fail, we return analysisError and let the optimizer handle it
         fail = funcs["fail"]
@@ -476,9 +479,16 @@ class DAFoamSolver(ImplicitComponent):
                 self.solution_counter += 1
 
             # compute the preconditioner matrix for the adjoint linear equation solution
-            # and initialize the ksp object. We reinitialize them every adjPCLag
-            adjPCLag = DASolver.getOption("adjPCLag")
-            if DASolver.dRdWTPC is None or DASolver.ksp is None or (self.solution_counter - 1) % adjPCLag == 0:
+            # and initialize the ksp object. We reinitialize them every adjPCLag, or
+            # when the adjoint convergence degrades if adjEqnOption->pcReuseMode = adaptive
+            if DASolver.getOption("adjEqnOption")["pcReuseMode"] == "adaptive":
+                needRebuild = renamed and DASolver.checkPCRebuild()
+            else:
+                adjPCLag = DASolver.getOption("adjPCLag")
+                needRebuild = (
+                    DASolver.dRdWTPC is None or DASolver.ksp is None or (self.solution_counter - 1) % adjPCLag == 0
+                )
+            if needRebuild:
                 if renamed:
                     DASolver.cdRoot()
                     # calculate the PC mat
@@ -500,6 +510,12 @@ class DAFoamSolver(ImplicitComponent):
         self._updateKSPTolerances(self.psi, dFdW, DASolver.ksp)
         # actually solving the adjoint linear equation using Petsc
         fail = DASolver.solverAD.solveLinearEqn(DASolver.ksp, dFdW, self.psi)
+        # solve_linear does not know which function the rhs comes from, and the coupled
+        # solver may call it several times per function with the tolerance set by
+        # _updateKSPTolerances, so we compare only the residual drop rate (per iteration)
+        # with the first solution after the last rebuild
+        if DASolver.getOption("adjEqnOption")["pcReuseMode"] == "adaptive":
+            DASolver.updatePCReuseStatus(DASolver.solverAD, "solve_linear", checkNIters=False)
         # convert the solution vector to array and assign it to d_residuals
         d_residuals["dafoam_states"] = DASolver.vec2Array(self.psi)
 
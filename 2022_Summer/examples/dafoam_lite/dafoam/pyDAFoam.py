@@ -17,6 +17,7 @@ import subprocess
 import os
 import sys
 import copy
+import json
 import shutil
 import numpy as np
 from mpi4py import MPI
@@ -433,7 +434,21 @@ class DAOPTION(object):
         ## Options for unsteady adjoint. mode can be hybridAdjoint or timeAccurateAdjoint
         ## Here nTimeInstances is the number of time instances and periodicity is the
         ## periodicity of flow oscillation (hybrid adjoint only)
-        self.unsteadyAdjoint = {"mode": "None", "nTimeInstances": -1, "periodicity": -1.0}
+        ## snapshotStore is where the state variables of the time instances are saved: memory,
+        ## mmap (a memory-mapped file in each processor folder, the OS pages the snapshots in and out),
+        ## or compressedDisk (one gzip compressed binary file per time instance)
+        ## For mmap and compressedDisk, the AD solver reads the snapshots from the files written in
+        ## the primal, so the snapshots are not copied to stateMat and stateBCMat in Python.
+        ## All time instances are stored, so the storage grows linearly with nTimeInstances. mmap and
+        ## compressedDisk move it from memory to disk, they do not reduce it. Checkpointing (storing
+        ## fewer instances and recomputing primal segments in the reverse sweep) is not supported yet.
+        ## The peak storage is printed after the primal and adjoint.
+        self.unsteadyAdjoint = {
+            "mode": "None",
+            "nTimeInstances": -1,
+            "periodicity": -1.0,
+            "snapshotStore": "memory",
+        }
 
         ## At which iteration should we start the averaging of objective functions.
         ## This is only used for unsteady solvers
@@ -445,6 +460,7 @@ class DAOPTION(object):
         ## This obviously increses the speed because the dRdWTPC computation takes about 30% of
         ## the adjoint total runtime. However, setting a too large lag value will decreases the speed
         ## of solving the adjoint equations. One needs to balance these factors
+        ## NOTE: adjPCLag is not used if adjEqnOption-pcReuseMode = adaptive
         self.adjPCLag = 10
 
         ## Whether to use AD: Mode options: forward, reverse, or fd. If forward mode AD is used
@@ -482,6 +498,17 @@ class DAOPTION(object):
         ## Whether running the optimization in the debug mode, which prints extra information.
         self.debug = False
 
+        ## Profile the hot paths in the C++ layer, e.g., primal iterations, residual evaluations,
+        ## coloring, Jacobian assembly, AD tape recording and evaluation, KSP setup and solution,
+        ## and field/Vec transfers. If active, we collect the wall time and the number of calls
+        ## for each phase, and the AD tape memory, and reduce them over all processors (min/max/avg).
+        ## The statistics are collected after each solvePrimal, solveAdjoint, and runColoring call, and
+        ## written to fileName in the json format, e.g., "solvePrimal_001": {"solver": {"timers": ...}}.
+        ## The coloring timers are under "runColoring_001": {"coloring": {"timers": ...}}.
+        ## If print is True, we also print them to screen. The timers add a few clock calls
+        ## per phase so they are turned off by default
+        self.profiling = {"active": False, "fileName": "profiling.json", "print": True}
+
         ## Whether to write Jacobian matrices to file for debugging
         ## Example:
         ##    writeJacobians = ["dRdWT", "dFdW"]
@@ -503,9 +530,32 @@ class DAOPTION(object):
         ## debugging the accuracy of partial computation, always set it to True
         self.adjUseColoring = True
 
+        ## Options for the distance-2 coloring used in computing the partial derivatives.
+        ## method: jonesPlassmannD2 (parallel Jones-Plassmann, it only communicates with the neighboring
+        ## processors) or parallelD2 (the original parallel heuristic algorithm).
+        ## ordering (jonesPlassmannD2 only): largestFirst colors the columns with more neighbors first, this
+        ## usually gives fewer colors, i.e., fewer residual evaluations for dRdW. random uses a hash ordering.
+        ## NOTE: the coloring is saved to disk and reused, delete the *Coloring_*.bin files to recompute it
+        self.adjColoringOption = {"method": "jonesPlassmannD2", "ordering": "largestFirst"}
+
         ## The Petsc options for solving the adjoint linear equation. These options should work for
         ## most of the case. If the adjoint does not converge, try to increase pcFillLevel to 2, or
         ## try "jacMatReOrdering": "nd"
+        ## multiRHSMode controls how the adjoint equations of all objective functions are solved.
+        ## "off": solve them one by one, each solution records its own AD tape for the matrix-free dRdWT.
+        ## "sharedTape": solve them one by one but record the AD tape only once.
+        ## "blockGMRES": solve them together using the block GMRES from Petsc (requires Petsc configured
+        ## with --download-hpddm). With useAD-mode=reverse, each tape sweep propagates multiple adjoint seeds,
+        ## so the number of tape sweeps per iteration no longer scales with the number of objective functions.
+        ## pcReuseMode controls when dRdWTPC and its preconditioner (ASM + ILU factorization) are rebuilt.
+        ## "lag": rebuild them every adjPCLag adjoint solutions, the KSP is re-created for each solution.
+        ## "adaptive": keep dRdWTPC and the KSP, including the ILU factorization, across adjoint solutions
+        ## and objective functions. The first solution of each objective function after a rebuild is the
+        ## reference. They are rebuilt before the next adjoint solution only if the number of GMRES
+        ## iterations is larger than pcRebuildIterRatio times the reference, or the residual drop rate
+        ## (orders of magnitude per iteration) is smaller than pcRebuildResDropRatio times the reference.
+        ## For the mphys coupled adjoint, only the residual drop rate is compared. Solutions with zero
+        ## iterations are not checked. All the reuse/rebuild decisions are printed to screen.
         self.adjEqnOption = {
             "globalPCIters": 0,
             "asmOverlap": 1,
@@ -520,6 +570,10 @@ class DAOPTION(object):
             "useNonZeroInitGuess": False,
             "useMGSO": False,
             "printInfo": 1,
+            "multiRHSMode": "off",
+            "pcReuseMode": "lag",
+            "pcRebuildIterRatio": 1.5,
+            "pcRebuildResDropRatio": 0.7,
         }
 
         ## Normalization for residuals. We should normalize all residuals!
@@ -700,13 +754,17 @@ class PYDAFOAM(object):
         # register solver names and set their types
         self._solverRegistry()
 
+        # the profiling statistics for each solvePrimal and solveAdjoint call
+        self.profilingStats = OrderedDict()
+
         # initialize the pySolvers
         self.solverInitialized = 0
         self._initSolver()
 
-        # initialize the number of primal and adjoint calls
+        # initialize the number of primal, adjoint, and coloring calls
         self.nSolvePrimals = 1
         self.nSolveAdjoints = 1
+        self.nRunColorings = 1
 
         # flags for primal and adjoint failure
         self.primalFail = 0
@@ -775,6 +833,9 @@ class PYDAFOAM(object):
         # a KSP object which may be used outside of the pyDAFoam class
         self.ksp = None
 
+        # the status of the preconditioner reuse, see adjEqnOption->pcReuseMode
+        self.pcReuseStatus = {"rebuild": True, "reason": "no preconditioner yet", "nReuses": 0, "refConvergence": {}}
+
         # the surface geometry/mesh displacement computed by the structural solver
         # this is used in FSI. Here self.surfGeoDisp is a N by 3 numpy array
         # that stores the displacement vector for each surface mesh point. The order of
@@ -1024,6 +1085,25 @@ class PYDAFOAM(object):
         if not self.getOption("useAD")["mode"] in ["fd", "reverse", "forward"]:
             raise Error("useAD->mode only supports fd, reverse, or forward!")
 
+        if not self.getOption("adjColoringOption")["method"] in ["jonesPlassmannD2", "parallelD2"]:
+            raise Error("adjColoringOption->method only supports jonesPlassmannD2 or parallelD2!")
+
+        if not self.getOption("adjColoringOption")["ordering"] in ["largestFirst", "random"]:
+            raise Error("adjColoringOption->ordering only supports largestFirst or random!")
+
+        if not self.getOption("adjEqnOption")["multiRHSMode"] in ["off", "sharedTape", "blockGMRES"]:
+            raise Error("adjEqnOption->multiRHSMode only supports off, sharedTape, or blockGMRES!")
+
+        if not self.getOption("adjEqnOption")["pcReuseMode"] in ["lag", "adaptive"]:
+            raise Error("adjEqnOption->pcReuseMode only supports lag or adaptive!")
+
+        if self.getOption("adjEqnOption")["pcReuseMode"] == "adaptive":
+            if self.getOption("runLowOrderPrimal4PC")["active"]:
+                raise Error("adjEqnOption->pcReuseMode=adaptive is not compatible with runLowOrderPrimal4PC")
+
+        if not self.getOption("unsteadyAdjoint")["snapshotStore"] in ["memory", "mmap", "compressedDisk"]:
+            raise Error("unsteadyAdjoint->snapshotStore only supports memory, mmap, or compressedDisk!")
+
         # check time accurate adjoint
         if self.getOption("unsteadyAdjoint")["mode"] == "timeAccurateAdjoint":
             if not self.getOption("useAD")["mode"] in ["forward", "reverse"]:
@@ -1098,17 +1178,23 @@ class PYDAFOAM(object):
         if adjMode == "hybridAdjoint" or adjMode == "timeAccurateAdjoint":
             nTimeInstances = self.getOption("unsteadyAdjoint")["nTimeInstances"]
 
-        self.stateMat = PETSc.Mat().create(PETSc.COMM_WORLD)
-        self.stateMat.setSizes(((nLocalAdjointStates, None), (None, nTimeInstances)))
-        self.stateMat.setFromOptions()
-        self.stateMat.setPreallocationNNZ((nTimeInstances, nTimeInstances))
-        self.stateMat.setUp()
-
-        self.stateBCMat = PETSc.Mat().create(PETSc.COMM_WORLD)
-        self.stateBCMat.setSizes(((nLocalAdjointBoundaryStates, None), (None, nTimeInstances)))
-        self.stateBCMat.setFromOptions()
-        self.stateBCMat.setPreallocationNNZ((nTimeInstances, nTimeInstances))
-        self.stateBCMat.setUp()
+        # the disk-backed stores pass the snapshots to solverAD through their files,
+        # so we need the mats only for the memory store
+        if self.getOption("unsteadyAdjoint")["snapshotStore"] == "memory":
+            self.stateMat = PETSc.Mat().create(PETSc.COMM_WORLD)
+            self.stateMat.setSizes(((nLocalAdjointStates, None), (None, nTimeInstances)))
+            self.stateMat.setFromOptions()
+            self.stateMat.setPreallocationNNZ((nTimeInstances, nTimeInstances))
+            self.stateMat.setUp()
+
+            self.stateBCMat = PETSc.Mat().create(PETSc.COMM_WORLD)
+            self.stateBCMat.setSizes(((nLocalAdjointBoundaryStates, None), (None, nTimeInstances)))
+            self.stateBCMat.setFromOptions()
+            self.stateBCMat.setPreallocationNNZ((nTimeInstances, nTimeInstances))
+            self.stateBCMat.setUp()
+        else:
+            self.stateMat = None
+            self.stateBCMat = None
 
         self.timeVec = PETSc.Vec().createSeq(nTimeInstances, bsize=1, comm=PETSc.COMM_SELF)
         self.timeIdxVec = PETSc.Vec().createSeq(nTimeInstances, bsize=1, comm=PETSc.COMM_SELF)
@@ -1902,10 +1988,251 @@ class PYDAFOAM(object):
             self.renameSolution(self.nSolvePrimals)
             self.writeDeformedFFDs(self.nSolvePrimals)
 
+        self.collectProfiling("solvePrimal_%03d" % self.nSolvePrimals)
+
         self.nSolvePrimals += 1
 
         return
 
+    def _getProfilingSolverNames(self):
+        """
+        Return the names of the initialized pySolvers. Each solver library has its own
+        profiling timers, so we collect them separately
+        """
+
+        solverNames = ["solver"]
+        if self.getOption("useAD")["mode"] in ["forward", "reverse"]:
+            solverNames.append("solverAD")
+        return solverNames
+
+    def collectProfiling(self, runName, pySolvers=None):
+        """
+        Collect the profiling statistics from the C++ layer, print them to screen, and write
+        them to the profiling file in the json format. Then reset the timers so that each
+        solvePrimal, solveAdjoint, or runColoring call has its own statistics.
+        NOTE: this is a collective call
+
+        Input:
+        ------
+        runName: the name of this run, e.g., solvePrimal_001
+
+        pySolvers: an OrderedDict of {name: pySolver} to collect, e.g., the coloring solver in
+        runColoring. If None, we collect the solvers from _getProfilingSolverNames
+
+        Output:
+        -------
+        self.profilingStats[runName]: the statistics for each solver library, e.g.,
+        self.profilingStats["solvePrimal_001"]["solver"]["timers"]["primal:iteration"]["time"]["max"]
+        """
+
+        profilingDict = self.getOption("profiling")
+        if not profilingDict["active"]:
+            return
+
+        if pySolvers is None:
+            pySolvers = OrderedDict()
+            for solverName in self._getProfilingSolverNames():
+                pySolvers[solverName] = getattr(self, solverName)
+
+        stats = OrderedDict()
+        for solverName, pySolver in pySolvers.items():
+            stats[solverName] = pySolver.getProfilingStatistics()
+            if profilingDict["print"]:
+                Info("Profiling statistics for %s in %s" % (solverName, runName))
+                pySolver.printProfiling()
+            pySolver.resetProfiling()
+
+        self.profilingStats[runName] = stats
+
+        # we write all the runs every time so the file is always a complete json
+        if self.comm.rank == 0:
+            with open(profilingDict["fileName"], "w") as f:
+                json.dump(self.profilingStats, f, indent=4)
+
+        return
+
+    def _calcdFdW4Adjoint(self, objFuncName):
+        """
+        Compute dFdW, the right-hand-side of the adjoint equation for objFuncName. For the
+        time accurate adjoint, the dRdWOldTPsi terms from the previous time steps are included
+
+        Parameters
+        ----------
+        objFuncName : str
+            Name of the objective function
+
+        Returns
+        -------
+        dFdW : PETSc.Vec
+            The right-hand-side vector, the caller needs to destroy it
+        """
+
+        wSize = self.solver.getNLocalAdjointStates()
+        dFdW = PETSc.Vec().create(PETSc.COMM_WORLD)
+        dFdW.setSizes((wSize, PETSc.DECIDE), bsize=1)
+        dFdW.setFromOptions()
+        if self.getOption("useAD")["mode"] == "fd":
+            self.solver.calcdFdW(self.xvVec, self.wVec, objFuncName.encode(), dFdW)
+        elif self.getOption("useAD")["mode"] == "reverse":
+            self.solverAD.calcdFdWAD(self.xvVec, self.wVec, objFuncName.encode(), dFdW)
+
+        # if it is time accurate adjoint, add extra terms for dFdW
+        if self.getOption("unsteadyAdjoint")["mode"] == "timeAccurateAdjoint":
+            # first copy the vectors from previous residual time step level
+            self.dR0dW0TPsi[objFuncName].copy(self.dR00dW0TPsi[objFuncName])
+            self.dR0dW00TPsi[objFuncName].copy(self.dR00dW00TPsi[objFuncName])
+            self.dRdW0TPsi[objFuncName].copy(self.dR0dW0TPsi[objFuncName])
+            self.dRdW00TPsi[objFuncName].copy(self.dR0dW00TPsi[objFuncName])
+            dFdW.axpy(-1.0, self.dR0dW0TPsi[objFuncName])
+            dFdW.axpy(-1.0, self.dR00dW00TPsi[objFuncName])
+
+        return dFdW
+
+    def _solveAdjointMultiRHS(self, ksp):
+        """
+        Solve the adjoint equations for all the objective functions in objFuncNames4Adj
+        together. The dFdW vectors are stored as the columns of a dense matrix and solved by
+        solveLinearEqnMultiRHS, such that all the solutions share one recorded dRdWT tape.
+        See adjEqnOption->multiRHSMode. The solutions are saved to self.adjVectors
+
+        Parameters
+        ----------
+        ksp : PETSc.KSP
+            The KSP object created by createMLRKSP or createMLRKSPMatrixFree
+        """
+
+        objFuncNames = [name for name in self.getOption("objFunc") if name in self.objFuncNames4Adj]
+        nRHS = len(objFuncNames)
+        if nRHS == 0:
+            return
+
+        wSize = self.solver.getNLocalAdjointStates()
+        rhsMat = PETSc.Mat().createDense(((wSize, PETSc.DECIDE), (PETSc.DECIDE, nRHS)), comm=PETSc.COMM_WORLD)
+        rhsMat.setUp()
+        solMat = rhsMat.duplicate()
+
+        # the local dense arrays have all nRHS columns, one column per objFunc
+        rhsArray = rhsMat.getDenseArray()
+        solArray = solMat.getDenseArray()
+        for idxI, objFuncName in enumerate(objFuncNames):
+            dFdW = self._calcdFdW4Adjoint(objFuncName)
+            rhsArray[:, idxI] = dFdW.getArray()
+            # previous adjoint solutions as the initial guess, used if useNonZeroInitGuess = True
+            solArray[:, idxI] = self.adjVectors[objFuncName].getArray()
+            dFdW.destroy()
+        rhsMat.assemble()
+        solMat.assemble()
+
+        if self.getOption("useAD")["mode"] == "fd":
+            self.adjointFail = self.solver.solveLinearEqnMultiRHS(ksp, rhsMat, solMat)
+            pySolver = self.solver
+        elif self.getOption("useAD")["mode"] == "reverse":
+            self.adjointFail = self.solverAD.solveLinearEqnMultiRHS(ksp, rhsMat, solMat)
+            pySolver = self.solverAD
+
+        # the convergence stats are the worst among all the columns
+        if self.getOption("adjEqnOption")["pcReuseMode"] == "adaptive":
+            self.updatePCReuseStatus(pySolver, "multiRHS")
+
+        solArray = solMat.getDenseArray()
+        for idxI, objFuncName in enumerate(objFuncNames):
+            self.adjVectors[objFuncName].setArray(solArray[:, idxI])
+
+            if self.getOption("unsteadyAdjoint")["mode"] == "timeAccurateAdjoint":
+                self.solverAD.calcdRdWOldTPsiAD(1, self.adjVectors[objFuncName], self.dRdW0TPsi[objFuncName])
+                self.solverAD.calcdRdWOldTPsiAD(2, self.adjVectors[objFuncName], self.dRdW00TPsi[objFuncName])
+
+        rhsMat.destroy()
+        solMat.destroy()
+
+    def checkPCRebuild(self):
+        """
+        Check whether dRdWTPC and the KSP need to be rebuilt before the next adjoint solution
+        for adjEqnOption->pcReuseMode = adaptive. The decision is printed to screen.
+        NOTE: if this function returns True, the caller must rebuild dRdWTPC and the KSP
+        because we reset the reference convergence here
+
+        Output:
+        -------
+        True if dRdWTPC and the KSP need to be rebuilt, otherwise False
+        """
+
+        status = self.pcReuseStatus
+
+        if self.dRdWTPC is None or self.ksp is None:
+            status["rebuild"] = True
+            status["reason"] = "no preconditioner yet"
+
+        if status["rebuild"]:
+            Info("PC reuse: rebuilding dRdWTPC and the KSP after %d reuses (%s)" % (status["nReuses"], status["reason"]))
+            status["rebuild"] = False
+            status["reason"] = ""
+            status["nReuses"] = 0
+            status["refConvergence"] = {}
+            return True
+        else:
+            status["nReuses"] += 1
+            Info("PC reuse: reusing dRdWTPC and the KSP, reuse %d since the last rebuild" % status["nReuses"])
+            return False
+
+    def updatePCReuseStatus(self, pySolver, rhsName, checkNIters=True):
+        """
+        Compare the adjoint convergence that just finished with the reference convergence, i.e.,
+        the first solution of rhsName after the last rebuild of dRdWTPC. If the convergence has
+        degraded past the thresholds in adjEqnOption, mark dRdWTPC and the KSP to be rebuilt
+        before the next adjoint solution. See adjEqnOption->pcReuseMode
+
+        Input:
+        ------
+        pySolver: the pySolver that solved the adjoint, i.e., self.solver or self.solverAD
+
+        rhsName: the name of the right-hand-side, e.g., the objective function name
+
+        checkNIters: whether to compare the number of iterations. Set it to False if the
+        tolerance changes between solutions of rhsName, e.g., the coupled adjoint in mphys,
+        then only the residual drop rate is compared
+        """
+
+        nIters = pySolver.getLinearEqnMaxNIters()
+        resDropRate = pySolver.getLinearEqnMinResDropRate()
+
+        status = self.pcReuseStatus
+        refConv = status["refConvergence"]
+
+        # the initial guess already met the tolerance so there is no drop rate to compare,
+        # see DALinearEqn::updateConvergenceStats
+        if nIters == 0:
+            Info("PC reuse: %s converged with 0 iterations, skip the convergence check" % rhsName)
+            return
+
+        if rhsName not in refConv:
+            refConv[rhsName] = [nIters, resDropRate]
+            Info(
+                "PC reuse: reference convergence for %s: %d iterations, residual drop %.4f per iteration"
+                % (rhsName, nIters, resDropRate)
+            )
+            return
+
+        nIters0, resDropRate0 = refConv[rhsName]
+        Info(
+            "PC reuse: %s: %d iterations (reference %d), residual drop %.4f per iteration (reference %.4f)"
+            % (rhsName, nIters, nIters0, resDropRate, resDropRate0)
+        )
+
+        iterRatio = self.getOption("adjEqnOption")["pcRebuildIterRatio"]
+        resDropRatio = self.getOption("adjEqnOption")["pcRebuildResDropRatio"]
+        if checkNIters and nIters > iterRatio * max(nIters0, 1):
+            status["rebuild"] = True
+            status["reason"] = "%s iterations %d > %g x %d" % (rhsName, nIters, iterRatio, nIters0)
+        elif resDropRate < resDropRatio * resDropRate0:
+            status["rebuild"] = True
+            status["reason"] = "%s residual drop %.4f < %g x %.4f" % (rhsName, resDropRate, resDropRatio, resDropRate0)
+
+        if status["rebuild"]:
+            Info("PC reuse: dRdWTPC will be rebuilt before the next adjoint solution (%s)" % status["reason"])
+
+        return
+
     def solveAdjoint(self):
         """
         Run adjoint solver to compute the adjoint vector psiVec
@@ -1960,57 +2287,76 @@ class PYDAFOAM(object):
         elif self.getOption("useAD")["mode"] == "reverse":
             self.solverAD.initializedRdWTMatrixFree(self.xvVec, self.wVec)
 
-        # calculate dRdWTPC. If runLowOrderPrimal4PC is true, we compute the PC mat
-        # before solving the primal, so we will skip it here
-        if not self.getOption("runLowOrderPrimal4PC")["active"]:
-            adjPCLag = self.getOption("adjPCLag")
-            if self.nSolveAdjoints == 1 or (self.nSolveAdjoints - 1) % adjPCLag == 0:
+        adjPCLag = self.getOption("adjPCLag")
+        pcReuseMode = self.getOption("adjEqnOption")["pcReuseMode"]
+
+        if pcReuseMode == "adaptive":
+            # keep dRdWTPC and the KSP across adjoint solutions unless the adjoint
+            # convergence has degraded, see self.checkPCRebuild
+            if self.checkPCRebuild():
+                if self.dRdWTPC is not None:
+                    self.dRdWTPC.destroy()
                 self.dRdWTPC = PETSc.Mat().create(PETSc.COMM_WORLD)
                 self.solver.calcdRdWT(self.xvVec, self.wVec, 1, self.dRdWTPC)
-
-        # Initialize the KSP object
-        ksp = PETSc.KSP().create(PETSc.COMM_WORLD)
-        if self.getOption("useAD")["mode"] == "fd":
-            self.solver.createMLRKSP(dRdWT, self.dRdWTPC, ksp)
-        elif self.getOption("useAD")["mode"] == "reverse":
-            self.solverAD.createMLRKSPMatrixFree(self.dRdWTPC, ksp)
-
-        # loop over all objFunc, calculate dFdW, and solve the adjoint
-        objFuncDict = self.getOption("objFunc")
-        wSize = self.solver.getNLocalAdjointStates()
-        for objFuncName in objFuncDict:
-            if objFuncName in self.objFuncNames4Adj:
-                dFdW = PETSc.Vec().create(PETSc.COMM_WORLD)
-                dFdW.setSizes((wSize, PETSc.DECIDE), bsize=1)
-                dFdW.setFromOptions()
+                if self.ksp is not None:
+                    self.ksp.destroy()
+                self.ksp = PETSc.KSP().create(PETSc.COMM_WORLD)
                 if self.getOption("useAD")["mode"] == "fd":
-                    self.solver.calcdFdW(self.xvVec, self.wVec, objFuncName.encode(), dFdW)
+                    self.solver.createMLRKSP(dRdWT, self.dRdWTPC, self.ksp)
                 elif self.getOption("useAD")["mode"] == "reverse":
-                    self.solverAD.calcdFdWAD(self.xvVec, self.wVec, objFuncName.encode(), dFdW)
-
-                # if it is time accurate adjoint, add extra terms for dFdW
-                if self.getOption("unsteadyAdjoint")["mode"] == "timeAccurateAdjoint":
-                    # first copy the vectors from previous residual time step level
-                    self.dR0dW0TPsi[objFuncName].copy(self.dR00dW0TPsi[objFuncName])
-                    self.dR0dW00TPsi[objFuncName].copy(self.dR00dW00TPsi[objFuncName])
-                    self.dRdW0TPsi[objFuncName].copy(self.dR0dW0TPsi[objFuncName])
-                    self.dRdW00TPsi[objFuncName].copy(self.dR0dW00TPsi[objFuncName])
-                    dFdW.axpy(-1.0, self.dR0dW0TPsi[objFuncName])
-                    dFdW.axpy(-1.0, self.dR00dW00TPsi[objFuncName])
-
-                # Initialize the adjoint vector psi and solve for it
+                    self.solverAD.createMLRKSPMatrixFree(self.dRdWTPC, self.ksp)
+            else:
+                # dRdWT is re-created for each adjoint solution so we need to update it in the KSP
                 if self.getOption("useAD")["mode"] == "fd":
-                    self.adjointFail = self.solver.solveLinearEqn(ksp, dFdW, self.adjVectors[objFuncName])
+                    self.solver.updateKSPOperators(dRdWT, self.dRdWTPC, self.ksp)
                 elif self.getOption("useAD")["mode"] == "reverse":
-                    self.adjointFail = self.solverAD.solveLinearEqn(ksp, dFdW, self.adjVectors[objFuncName])
+                    self.solverAD.updateKSPOperatorsMatrixFree(self.dRdWTPC, self.ksp)
+            ksp = self.ksp
+        else:
+            # calculate dRdWTPC. If runLowOrderPrimal4PC is true, we compute the PC mat
+            # before solving the primal, so we will skip it here
+            if not self.getOption("runLowOrderPrimal4PC")["active"]:
+                if self.nSolveAdjoints == 1 or (self.nSolveAdjoints - 1) % adjPCLag == 0:
+                    self.dRdWTPC = PETSc.Mat().create(PETSc.COMM_WORLD)
+                    self.solver.calcdRdWT(self.xvVec, self.wVec, 1, self.dRdWTPC)
+
+            # Initialize the KSP object
+            ksp = PETSc.KSP().create(PETSc.COMM_WORLD)
+            if self.getOption("useAD")["mode"] == "fd":
+                self.solver.createMLRKSP(dRdWT, self.dRdWTPC, ksp)
+            elif self.getOption("useAD")["mode"] == "reverse":
+                self.solverAD.createMLRKSPMatrixFree(self.dRdWTPC, ksp)
 
-                if self.getOption("unsteadyAdjoint")["mode"] == "timeAccurateAdjoint":
-                    self.solverAD.calcdRdWOldTPsiAD(1, self.adjVectors[objFuncName], self.dRdW0TPsi[objFuncName])
-                    self.solverAD.calcdRdWOldTPsiAD(2, self.adjVectors[objFuncName], self.dRdW00TPsi[objFuncName])
+        if self.getOption("adjEqnOption")["multiRHSMode"] != "off":
+            # solve the adjoint equations for all objFunc together, sharing one dRdWT tape
+            self._solveAdjointMultiRHS(ksp)
+        else:
+            # loop over all objFunc, calculate dFdW, and solve the adjoint
+            objFuncDict = self.getOption("objFunc")
+            for objFuncName in objFuncDict:
+                if objFuncName in self.objFuncNames4Adj:
+                    dFdW = self._calcdFdW4Adjoint(objFuncName)
 
-                dFdW.destroy()
+                    # Initialize the adjoint vector psi and solve for it
+                    if self.getOption("useAD")["mode"] == "fd":
+                        self.adjointFail = self.solver.solveLinearEqn(ksp, dFdW, self.adjVectors[objFuncName])
+                        pySolver = self.solver
+                    elif self.getOption("useAD")["mode"] == "reverse":
+                        self.adjointFail = self.solverAD.solveLinearEqn(ksp, dFdW, self.adjVectors[objFuncName])
+                        pySolver = self.solverAD
 
-        ksp.destroy()
+                    if pcReuseMode == "adaptive":
+                        self.updatePCReuseStatus(pySolver, objFuncName)
+
+                    if self.getOption("unsteadyAdjoint")["mode"] == "timeAccurateAdjoint":
+                        self.solverAD.calcdRdWOldTPsiAD(1, self.adjVectors[objFuncName], self.dRdW0TPsi[objFuncName])
+                        self.solverAD.calcdRdWOldTPsiAD(2, self.adjVectors[objFuncName], self.dRdW00TPsi[objFuncName])
+
+                    dFdW.destroy()
+
+        # for pcReuseMode = adaptive, ksp is self.ksp and we keep it for the next adjoint solution
+        if pcReuseMode != "adaptive":
+            ksp.destroy()
         if self.getOption("useAD")["mode"] == "fd":
             dRdWT.destroy()
         elif self.getOption("useAD")["mode"] == "reverse":
@@ -2385,10 +2731,12 @@ class PYDAFOAM(object):
             else:
                 raise Error("designVarType %s not supported!" % designVarDict[designVarName]["designVarType"])
 
+        self.collectProfiling("solveAdjoint_%03d" % self.nSolveAdjoints)
+
         self.nSolveAdjoints += 1
 
         # we destroy dRdWTPC only when we need to recompute it next time
-        if (self.nSolveAdjoints - 1) % adjPCLag == 0:
+        if pcReuseMode != "adaptive" and (self.nSolveAdjoints - 1) % adjPCLag == 0:
             self.dRdWTPC.destroy()
 
         return
@@ -2446,40 +2794,10 @@ class PYDAFOAM(object):
         # Calculate number of surface points
         nPts, _ = self._getSurfaceSize(self.allWallsGroup)
 
-        # Initialize PETSc vectors
-        pointListTemp = PETSc.Vec().create(comm=PETSc.COMM_WORLD)
-        pointListTemp.setSizes((nPts, PETSc.DECIDE), bsize=1)
-        pointListTemp.setFromOptions()
-
-        fX = PETSc.Vec().create(comm=PETSc.COMM_WORLD)
-        fX.setSizes((nPts, PETSc.DECIDE), bsize=1)
-        fX.setFromOptions()
-
-        fY = PETSc.Vec().create(comm=PETSc.COMM_WORLD)
-        fY.setSizes((nPts, PETSc.DECIDE), bsize=1)
-        fY.setFromOptions()
-
-        fZ = PETSc.Vec().create(comm=PETSc.COMM_WORLD)
-        fZ.setSizes((nPts, PETSc.DECIDE), bsize=1)
-        fZ.setFromOptions()
-
-        # Compute forces
-        self.solver.getForces(fX, fY, fZ, pointListTemp)
-
-        # Copy data from PETSc vectors
-        forces = np.zeros((nPts, 3))
-        forces[:, 0] = np.copy(fX.getArray())
-        forces[:, 1] = np.copy(fY.getArray())
-        forces[:, 2] = np.copy(fZ.getArray())
-
-        # comment out this var since it is not used.
-        # pointList = np.copy(pointListTemp.getArray())
-
-        # Cleanup PETSc vectors
-        fX.destroy()
-        fY.destroy()
-        fZ.destroy()
-        pointListTemp.destroy()
+        # Compute forces, the C++ layer writes them directly to the forces array
+        # so we don't need to create and copy the fX, fY, and fZ vectors
+        forces = np.zeros((nPts, 3), self.dtype)
+        self.solver.getForcesArray(forces)
 
         # Print total force
         fXSum = np.sum(forces[:, 0])
@@ -2642,6 +2960,10 @@ class PYDAFOAM(object):
         if self.getOption("printDAOptions"):
             self.solver.printAllOptions()
 
+        if self.getOption("profiling")["active"]:
+            for solverName in self._getProfilingSolverNames():
+                getattr(self, solverName).setProfilingActive(1)
+
         adjMode = self.getOption("unsteadyAdjoint")["mode"]
         if adjMode == "hybridAdjoint" or adjMode == "timeAccurateAdjoint":
             self.initTimeInstanceMats()
@@ -2683,8 +3005,15 @@ class PYDAFOAM(object):
             solver = pyColoringSolid(solverArg.encode(), self.options)
         else:
             raise Error("pyDAFoam: %s not registered! Check _solverRegistry(self)." % solverName)
+
+        if self.getOption("profiling")["active"]:
+            solver.setProfilingActive(1)
+
         solver.run()
 
+        self.collectProfiling("runColoring_%03d" % self.nRunColorings, OrderedDict([("coloring", solver)]))
+        self.nRunColorings += 1
+
         solver = None
 
         return
@@ -3534,6 +3863,31 @@ class PYDAFOAM(object):
 
         self.solver.updateBoundaryConditions(fieldName, fieldType)
 
+    def getOFFieldView(self, fieldName, fieldType):
+        """
+        Return a zero-copy view of the internal field of an OpenFOAM field in the
+        primal solver (self.solver). The view's getArray() returns a NumPy array that maps
+        directly onto the OpenFOAM storage, with the shape (nLocalCells,) for scalar and
+        (nLocalCells, 3) for vector. Changing the array changes the OpenFOAM field in place,
+        after that, call updateBoundaryConditions(fieldName, fieldType).
+        NOTE: delete all the arrays and call view.release() when they are no longer needed,
+        the view must not be used after the field is resized or destroyed
+
+        Parameters
+        ----------
+        fieldName : str
+           Name of the flow field, e.g., U, p, nuTilda
+        fieldType : str
+           Type of the flow field: scalar or vector
+
+        Returns
+        -------
+        view : pyDAArrayView
+            The zero-copy view
+        """
+
+        return self.solver.getOFFieldView(fieldName.encode(), fieldType.encode())
+
     def getOption(self, name):
         """
         Get a value from options
@@ -3612,34 +3966,40 @@ class PYDAFOAM(object):
                 DVSizes.append(size)
             return DVNames, DVSizes
 
-    def getStates(self):
+    def getStates(self, copy=True):
         """
         Return the adjoint state array owns by this processor
-        """
-        nLocalStateSize = self.solver.getNLocalAdjointStates()
-        states = np.zeros(nLocalStateSize, self.dtype)
-        Istart, Iend = self.wVec.getOwnershipRange()
-        for i in range(Istart, Iend):
-            iRel = i - Istart
-            states[iRel] = self.wVec[i]
 
-        return states
+        Parameters
+        ----------
+        copy : bool
+            If False, return a read-only pyDAArrayView of the local array of self.wVec,
+            i.e., no copy, and view.getArray() returns the NumPy array. self.wVec is
+            locked until view.release() is called, so delete all the arrays and call
+            view.release() before self.wVec is changed, e.g., by setStates or the primal
+        """
+        if copy:
+            states = self.wVec.getArray(readonly=True)
+            return np.array(states, self.dtype)
+        else:
+            return self.solver.getVecView(self.wVec)
 
-    def getResiduals(self):
+    def getResiduals(self, residuals=None):
         """
         Return the residual array owns by this processor
-        """
-        nLocalStateSize = self.solver.getNLocalAdjointStates()
-        residuals = np.zeros(nLocalStateSize, self.dtype)
-        resVec = self.wVec.duplicate()
-        resVec.zeroEntries()
 
-        self.solver.calcResidualVec(resVec)
+        Parameters
+        ----------
+        residuals : array
+            If provided, the residuals are written to this array in place, it needs to be a
+            contiguous float64 array with nLocalAdjointStates elements. The C++ layer writes
+            to its memory directly, so no temporary Vec is created
+        """
+        if residuals is None:
+            nLocalStateSize = self.solver.getNLocalAdjointStates()
+            residuals = np.zeros(nLocalStateSize, self.dtype)
 
-        Istart, Iend = resVec.getOwnershipRange()
-        for i in range(Istart, Iend):
-            iRel = i - Istart
-            residuals[iRel] = resVec[i]
+        self.solver.calcResidualArray(residuals)
 
         return residuals
 
@@ -3647,13 +4007,8 @@ class PYDAFOAM(object):
         """
         Set the state to the OpenFOAM field
         """
-        Istart, Iend = self.wVec.getOwnershipRange()
-        for i in range(Istart, Iend):
-            iRel = i - Istart
-            self.wVec[i] = states[iRel]
-
-        self.wVec.assemblyBegin()
-        self.wVec.assemblyEnd()
+        # copy the states to the local array of wVec in one shot
+        self.wVec.setArray(states)
 
         self.solver.updateOFField(self.wVec)
 
@@ -3670,9 +4025,8 @@ class PYDAFOAM(object):
         seqVec = PETSc.Vec().createSeq(vecSize, bsize=1, comm=PETSc.COMM_SELF)
         self.solver.convertMPIVec2SeqVec(mpiVec, seqVec)
 
-        array1 = np.zeros(vecSize, self.dtype)
-        for i in range(vecSize):
-            array1[i] = seqVec[i]
+        array1 = np.array(seqVec.getArray(readonly=True), self.dtype)
+        seqVec.destroy()
 
         return array1
 
@@ -3681,13 +4035,7 @@ class PYDAFOAM(object):
         Convert a Petsc vector to numpy array
         """
 
-        Istart, Iend = vec.getOwnershipRange()
-        size = Iend - Istart
-        array1 = np.zeros(size, self.dtype)
-        for i in range(Istart, Iend):
-            iRel = i - Istart
-            array1[iRel] = vec[i]
-        return array1
+        return np.array(vec.getArray(readonly=True), self.dtype)
 
     def array2Vec(self, array1):
         """
@@ -3698,15 +4046,7 @@ class PYDAFOAM(object):
         vec = PETSc.Vec().create(PETSc.COMM_WORLD)
         vec.setSizes((size, PETSc.DECIDE), bsize=1)
         vec.setFromOptions()
-        vec.zeroEntries()
-
-        Istart, Iend = vec.getOwnershipRange()
-        for i in range(Istart, Iend):
-            iRel = i - Istart
-            vec[i] = array1[iRel]
-
-        vec.assemblyBegin()
-        vec.assemblyEnd()
+        vec.setArray(array1)
 
         return vec
 
@@ -3717,13 +4057,7 @@ class PYDAFOAM(object):
         size = len(array1)
 
         vec = PETSc.Vec().createSeq(size, bsize=1, comm=PETSc.COMM_SELF)
-        vec.zeroEntries()
-
-        for i in range(size):
-            vec[i] = array1[i]
-
-        vec.assemblyBegin()
-        vec.assemblyEnd()
+        vec.setArray(array1)
 
         return vec
 
@@ -3732,11 +4066,7 @@ class PYDAFOAM(object):
         Convert a Petsc vector to numpy array in serial mode
         """
 
-        size = vec.getSize()
-        array1 = np.zeros(size, self.dtype)
-        for i in range(size):
-            array1[i] = vec[i]
-        return array1
+        return np.array(vec.getArray(readonly=True), self.dtype)
 
     def cdRoot(self):
         """
@@ -14,6 +14,14 @@
 
 # for using Petsc
 from petsc4py.PETSc cimport Vec, PetscVec, Mat, PetscMat, KSP, PetscKSP
+from cpython.buffer cimport PyBUF_WRITABLE
+
+# the Petsc functions to access the local array of a Vec without copying
+cdef extern from "petscvec.h":
+    int VecGetArrayRead(PetscVec, const double **)
+    int VecRestoreArrayRead(PetscVec, const double **)
+
+import numpy as np
 
 # declare cpp functions
 cdef extern from "DASolvers.H" namespace "Foam":
@@ -29,7 +37,12 @@ cdef extern from "DASolvers.H" namespace "Foam":
         void calcdFdWAD(PetscVec, PetscVec, char *, PetscVec)
         void createMLRKSP(PetscMat, PetscMat, PetscKSP)
         void createMLRKSPMatrixFree(PetscMat, PetscKSP)
+        void updateKSPOperators(PetscMat, PetscMat, PetscKSP)
+        void updateKSPOperatorsMatrixFree(PetscMat, PetscKSP)
+        int getLinearEqnMaxNIters()
+        double getLinearEqnMinResDropRate()
         void solveLinearEqn(PetscKSP, PetscVec, PetscVec)
+        int solveLinearEqnMultiRHS(PetscKSP, PetscMat, PetscMat)
         void calcdRdBC(PetscVec, PetscVec, char *, PetscMat)
         void calcdFdBC(PetscVec, PetscVec, char *, char *, PetscVec)
         void calcdFdBCAD(PetscVec, PetscVec, char *, char *, PetscVec)
@@ -65,6 +78,7 @@ cdef extern from "DASolvers.H" namespace "Foam":
         int checkMesh()
         double getObjFuncValue(char *)
         void getForces(PetscVec, PetscVec, PetscVec, PetscVec)
+        void getForcesArray(double *, int)
         void printAllOptions()
         void updateDAOption(object)
         double getPrevPrimalSolTime()
@@ -87,12 +101,122 @@ cdef extern from "DASolvers.H" namespace "Foam":
         void calcPrimalResidualStatistics(char *)
         double getForwardADDerivVal(char *)
         void calcResidualVec(PetscVec)
+        void calcResidualArray(double *, int)
+        int getOFFieldSize(char *, char *)
+        double * getOFFieldData(char *, char *)
         void setPrimalBoundaryConditions(int)
         void calcFvSource(PetscVec, PetscVec, PetscVec, PetscVec)
         void calcdFvSourcedInputsTPsiAD(char *, PetscVec, PetscVec, PetscVec, PetscVec, PetscVec)
         void calcForceProfile(PetscVec, PetscVec, PetscVec, PetscVec)
         void calcdForcedStateTPsiAD(char *, PetscVec, PetscVec, PetscVec, PetscVec)
-    
+        void setProfilingActive(int)
+        object getProfilingStatistics()
+        void resetProfiling()
+        void printProfiling()
+    
+# a zero-copy view of a double array owned by the cpp layer
+cdef class pyDAArrayView:
+    """
+    A zero-copy view of a contiguous double array owned by the cpp layer, e.g., the
+    internal field of an OpenFOAM field. It supports the buffer protocol, so
+    np.asarray(view) maps directly onto the cpp storage without copying.
+    Call release() once the arrays are no longer needed. The view can not
+    be released while any array created from it is still alive.
+    NOTE: the storage is owned by OpenFOAM, so we need to release the view
+    before the field is resized or destroyed, and call updateBoundaryConditions
+    after changing the field values through the view.
+    For a view of a Petsc Vec (see getVecView), the view is read-only and the Vec
+    is locked by VecGetArrayRead until release() is called
+    """
+
+    cdef:
+        double * _data
+        Py_ssize_t _shape[2]
+        Py_ssize_t _strides[2]
+        int _ndim
+        int _nExports
+        int _readonly
+        object _owner
+        PetscVec _vec
+
+    def __cinit__(self):
+        self._data = NULL
+        self._ndim = 1
+        self._nExports = 0
+        self._readonly = 0
+        self._owner = None
+        self._vec = NULL
+
+    def __dealloc__(self):
+        # restore the Vec array if the view is deleted without calling release()
+        cdef const double * data = self._data
+        if self._vec != NULL:
+            VecRestoreArrayRead(self._vec, &data)
+            self._vec = NULL
+
+    def __getbuffer__(self, Py_buffer * buffer, int flags):
+        if self._data == NULL:
+            raise ValueError("pyDAArrayView: the view has been released!")
+        if self._readonly and (flags & PyBUF_WRITABLE):
+            raise BufferError("pyDAArrayView: the view is read-only!")
+        buffer.buf = <void *> self._data
+        buffer.format = b"d"
+        buffer.internal = NULL
+        buffer.itemsize = sizeof(double)
+        buffer.len = self._shape[0] * self._shape[1] * sizeof(double)
+        buffer.ndim = self._ndim
+        buffer.obj = self
+        buffer.readonly = self._readonly
+        buffer.shape = self._shape
+        buffer.strides = self._strides
+        buffer.suboffsets = NULL
+        self._nExports += 1
+
+    def __releasebuffer__(self, Py_buffer * buffer):
+        self._nExports -= 1
+
+    def getArray(self):
+        """
+        Return a NumPy array that shares the memory with the cpp storage
+        """
+        # NOTE: np.asarray does not raise if the buffer is not available,
+        # it returns an object array instead, so we check it here
+        if self._data == NULL:
+            raise ValueError("pyDAArrayView: the view has been released!")
+        return np.asarray(memoryview(self))
+
+    def release(self):
+        """
+        Release the view, after that, the view can not be used anymore
+        """
+        cdef const double * data = self._data
+        if self._nExports > 0:
+            raise RuntimeError("pyDAArrayView: %d arrays still use this view, delete them first!" % self._nExports)
+        if self._vec != NULL:
+            VecRestoreArrayRead(self._vec, &data)
+            self._vec = NULL
+        self._data = NULL
+        self._owner = None
+
+cdef pyDAArrayView createArrayView(object owner, double * data, Py_ssize_t size, Py_ssize_t nComps):
+    # the array has the shape (size / nComps, nComps) if nComps > 1, otherwise (size,)
+    cdef pyDAArrayView view = pyDAArrayView()
+    view._data = data
+    view._owner = owner
+    if nComps > 1:
+        view._ndim = 2
+        view._shape[0] = size // nComps
+        view._shape[1] = nComps
+        view._strides[0] = nComps * sizeof(double)
+        view._strides[1] = sizeof(double)
+    else:
+        view._ndim = 1
+        view._shape[0] = size
+        view._shape[1] = 1
+        view._strides[0] = sizeof(double)
+        view._strides[1] = sizeof(double)
+    return view
+
 # create python wrappers that call cpp functions
 cdef class pyDASolvers:
 
@@ -162,9 +286,24 @@ cdef class pyDASolvers:
     def createMLRKSPMatrixFree(self, Mat jacPCMat, KSP myKSP):
         self._thisptr.createMLRKSPMatrixFree(jacPCMat.mat, myKSP.ksp)
     
+    def updateKSPOperators(self, Mat jacMat, Mat jacPCMat, KSP myKSP):
+        self._thisptr.updateKSPOperators(jacMat.mat, jacPCMat.mat, myKSP.ksp)
+    
+    def updateKSPOperatorsMatrixFree(self, Mat jacPCMat, KSP myKSP):
+        self._thisptr.updateKSPOperatorsMatrixFree(jacPCMat.mat, myKSP.ksp)
+    
+    def getLinearEqnMaxNIters(self):
+        return self._thisptr.getLinearEqnMaxNIters()
+    
+    def getLinearEqnMinResDropRate(self):
+        return self._thisptr.getLinearEqnMinResDropRate()
+    
     def solveLinearEqn(self, KSP myKSP, Vec rhsVec, Vec solVec):
         self._thisptr.solveLinearEqn(myKSP.ksp, rhsVec.vec, solVec.vec)
 
+    def solveLinearEqnMultiRHS(self, KSP myKSP, Mat rhsMat, Mat solMat):
+        return self._thisptr.solveLinearEqnMultiRHS(myKSP.ksp, rhsMat.mat, solMat.mat)
+
     def calcdRdBC(self, Vec xvVec, Vec wVec, designVarName, Mat dRdBC):
         self._thisptr.calcdRdBC(xvVec.vec, wVec.vec, designVarName, dRdBC.mat)
     
@@ -281,6 +420,12 @@ cdef class pyDASolvers:
 
     def getForces(self, Vec fX, Vec fY, Vec fZ, Vec pointList):
         self._thisptr.getForces(fX.vec, fY.vec, fZ.vec, pointList.vec)
+    
+    def getForcesArray(self, double[:, ::1] forces):
+        cdef double * forcesPtr = NULL
+        if forces.shape[0] > 0:
+            forcesPtr = &forces[0, 0]
+        self._thisptr.getForcesArray(forcesPtr, forces.shape[0] * forces.shape[1])
 
     def printAllOptions(self):
         self._thisptr.printAllOptions()
@@ -313,7 +458,14 @@ cdef class pyDASolvers:
         self._thisptr.setTimeInstanceField(instanceI)
     
     def setTimeInstanceVar(self, mode, Mat stateMat, Mat stateBCMat, Vec timeVec, Vec timeIdxVec):
-        self._thisptr.setTimeInstanceVar(mode, stateMat.mat, stateBCMat.mat, timeVec.vec, timeIdxVec.vec)
+        # stateMat and stateBCMat are None for the disk-backed snapshot stores
+        cdef PetscMat stateMatC = NULL
+        cdef PetscMat stateBCMatC = NULL
+        if stateMat is not None:
+            stateMatC = stateMat.mat
+        if stateBCMat is not None:
+            stateBCMatC = stateBCMat.mat
+        self._thisptr.setTimeInstanceVar(mode, stateMatC, stateBCMatC, timeVec.vec, timeIdxVec.vec)
     
     def getTimeInstanceObjFunc(self, instanceI, objFuncName):
         return self._thisptr.getTimeInstanceObjFunc(instanceI, objFuncName)
@@ -333,6 +485,28 @@ cdef class pyDASolvers:
     def calcResidualVec(self, Vec resVec):
         self._thisptr.calcResidualVec(resVec.vec)
     
+    def calcResidualArray(self, double[::1] resArray):
+        cdef double * resPtr = NULL
+        if resArray.shape[0] > 0:
+            resPtr = &resArray[0]
+        self._thisptr.calcResidualArray(resPtr, resArray.shape[0])
+    
+    def getOFFieldView(self, fieldName, fieldType):
+        cdef int size = self._thisptr.getOFFieldSize(fieldName, fieldType)
+        cdef double * data = self._thisptr.getOFFieldData(fieldName, fieldType)
+        nComps = 3 if fieldType == b"vector" else 1
+        return createArrayView(self, data, size, nComps)
+    
+    def getVecView(self, Vec vec):
+        # a read-only view of the local array of vec, the Vec stays locked until view.release()
+        cdef const double * data = NULL
+        cdef pyDAArrayView view
+        VecGetArrayRead(vec.vec, &data)
+        view = createArrayView(vec, <double *> data, vec.getLocalSize(), 1)
+        view._readonly = 1
+        view._vec = vec.vec
+        return view
+    
     def setPrimalBoundaryConditions(self, printInfo):
         self._thisptr.setPrimalBoundaryConditions(printInfo)
     
@@ -347,3 +521,15 @@ cdef class pyDASolvers:
     
     def calcdForcedStateTPsiAD(self, mode, Vec xv, Vec state, Vec psi, Vec prod):
         self._thisptr.calcdForcedStateTPsiAD(mode, xv.vec, state.vec, psi.vec, prod.vec)
+
+    def setProfilingActive(self, active):
+        self._thisptr.setProfilingActive(active)
+
+    def getProfilingStatistics(self):
+        return self._thisptr.getProfilingStatistics()
+
+    def resetProfiling(self):
+        self._thisptr.resetProfiling()
+
+    def printProfiling(self):
+        self._thisptr.printProfiling()
@@ -17,6 +17,10 @@ cdef extern from "ColoringIncompressible.H" namespace "Foam":
     cppclass ColoringIncompressible:
         ColoringIncompressible(char *, object) except +
         void run()
+        void setProfilingActive(int)
+        object getProfilingStatistics()
+        void resetProfiling()
+        void printProfiling()
 
 # create python wrappers that call cpp functions
 cdef class pyColoringIncompressible:
@@ -55,3 +59,15 @@ cdef class pyColoringIncompressible:
     # wrap all the other member functions in the cpp class
     def run(self):
         self._thisptr.run()
+
+    def setProfilingActive(self, active):
+        self._thisptr.setProfilingActive(active)
+
+    def getProfilingStatistics(self):
+        return self._thisptr.getProfilingStatistics()
+
+    def resetProfiling(self):
+        self._thisptr.resetProfiling()
+
+    def printProfiling(self):
+        self._thisptr.printProfiling()